@@ -74,6 +74,7 @@ public:
 	unsigned char GetAcqMode() { return acqMode; }
 
 	double GetTimeStamp() { return timeStamp; }
+	unsigned short GetNHits() { return NHits; }
   eventTiming GetTimingEvent(unsigned int);
   eventSpecTiming GetSpecTimingEvent(unsigned int);
   
@@ -19,6 +19,8 @@ det::~det()
 // the unpack class handles the opened data file, unpacks each event
 bool det::unpack(ifstream *pevtfile)
 { 
+  if (Histo->fastMode) return unpackFast(pevtfile);
+
   nevts = 0;
   long nbytes = 0;
   nbytes = SIPMevent->ReadEventFromStream(pevtfile);
@@ -90,3 +92,59 @@ bool det::unpack(ifstream *pevtfile)
 
   return true;
 }
+
+// histogram-only mode: every hit of every event is run through the fill plan
+// compiled from the spec file, nothing is written to the tree
+bool det::unpackFast(ifstream *pevtfile)
+{
+  nevts = 0;
+  long nbytes = SIPMevent->ReadEventFromStream(pevtfile);
+  // an empty file never reads the header, so acqMode is not known
+  if(nbytes == -1) return true;
+  unsigned char acqMode = SIPMevent->GetAcqMode();
+
+  // timing-only data has no low/high gain values
+  bool provided[NSPECVARS] = {true, acqMode == 0x03, acqMode == 0x03, true, true};
+  Histo->CheckPlanVars(provided);
+
+  float vals[NSPECVARS];
+  int chan;
+  eventSpecTiming evSpec;
+  eventTiming ev;
+  for(;;)
+  {
+    if(nbytes == -1) break;
+
+    unsigned short nhits = SIPMevent->GetNHits();
+    for (unsigned short i = 0; i < nhits; i++)
+    {
+      if (acqMode == 0x03) {
+        evSpec = SIPMevent->GetSpecTimingEvent(i);
+        chan = evSpec.chan;
+        vals[VAR_LOW] = evSpec.low;
+        vals[VAR_HIGH] = evSpec.high;
+        vals[VAR_TOA] = evSpec.ToA;
+        vals[VAR_TOT] = evSpec.ToT;
+      }
+      else {
+        ev = SIPMevent->GetTimingEvent(i);
+        chan = ev.chan;
+        vals[VAR_LOW] = 0;
+        vals[VAR_HIGH] = 0;
+        vals[VAR_TOA] = ev.ToA;
+        vals[VAR_TOT] = ev.ToT;
+      }
+      vals[VAR_CHAN] = chan;
+      Histo->FillPlan(chan, vals);
+    }
+
+    SIPMevent->clear();
+    nevts++;
+    if (nevts % 100000 == 0) cout << "event # " << nevts << endl;
+
+    nbytes = SIPMevent->ReadEventFromStream(pevtfile);
+  }
+
+  cout << "events read: " << nevts << endl;
+  return true;
+}
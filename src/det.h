@@ -17,6 +17,7 @@ class det
   histo* Histo;
 
   bool unpack(ifstream *);
+  bool unpackFast(ifstream *);
   
   Event* SIPMevent;
   long nevts;
@@ -1,4 +1,6 @@
 #include "histo.h"
+#include <stdexcept>
+#include <cmath>
 
 histo::histo() {
   // create root file
@@ -15,6 +17,33 @@ histo::histo() {
   toa_hist = new TH1F("toa_hist", "Time of Arrival", 4096, 0, 4096);
 }
 
+// histogram-only mode: no tree is created, only the histograms in the spec
+histo::histo(string specFile) {
+  fastMode = true;
+
+  // validate the spec before touching sort.root so a typo keeps old output
+  vector<histSpec> specs = LoadSpec(specFile);
+
+  file_read = new TFile("sort.root","RECREATE");
+  file_read->cd();
+
+  for (const histSpec& spec : specs) {
+    fillStep step;
+    if (spec.yvar >= 0)
+      step.hist2 = new TH2F(spec.name.c_str(), spec.name.c_str(), spec.nbinsx, spec.xlo, spec.xhi,
+                            spec.nbinsy, spec.ylo, spec.yhi);
+    else
+      step.hist = new TH1F(spec.name.c_str(), spec.name.c_str(), spec.nbinsx, spec.xlo, spec.xhi);
+    step.xvar = spec.xvar;
+    step.yvar = spec.yvar;
+    step.chanMask = spec.chanMask;
+    step.cutVar = spec.cutVar;
+    step.op = spec.op;
+    step.cutVal = spec.cutVal;
+    plan.push_back(step);
+  }
+}
+
 histo::~histo() {
   file_read->Write();
   cout << "file written" << endl;
@@ -45,3 +74,182 @@ void histo::FillTree(double ts, float th, float a) {
   toa = a;
   t->Fill();
 }
+
+// turn a variable name from the spec file into its index in the hit values
+static int ParseVar(string name, int line) {
+  if (name == "chan") return VAR_CHAN;
+  if (name == "low")  return VAR_LOW;
+  if (name == "high") return VAR_HIGH;
+  if (name == "toa")  return VAR_TOA;
+  if (name == "tot")  return VAR_TOT;
+  throw invalid_argument("histogram spec line " + to_string(line) + ": unknown variable " + name);
+}
+
+// stoi/stod/stof stop at the first bad character, so also check that the
+// whole token was used up
+static int ParseInt(string s, int line, string what) {
+  size_t pos = 0;
+  int val = 0;
+  try { val = stoi(s, &pos); }
+  catch (const logic_error&) { pos = 0; }
+  if (s.empty() || pos != s.size())
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad " + what + " " + s);
+  return val;
+}
+
+static double ParseDouble(string s, int line, string what) {
+  size_t pos = 0;
+  double val = 0;
+  try { val = stod(s, &pos); }
+  catch (const logic_error&) { pos = 0; }
+  if (s.empty() || pos != s.size())
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad " + what + " " + s);
+  return val;
+}
+
+// "all" or a comma separated list of channels and ranges, e.g. 0,4-7
+static unsigned long long ParseChans(string chans, int line) {
+  if (chans == "all") return ~0ULL;
+
+  unsigned long long mask = 0;
+  // getline drops a trailing empty item, so catch "0," here like "0,,3"
+  if (chans.back() == ',')
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad channel list " + chans);
+
+  stringstream ss(chans);
+  string item;
+  while (getline(ss, item, ',')) {
+    size_t dash = item.find('-');
+    int first = ParseInt(item.substr(0, dash), line, "channel list");
+    int last = (dash == string::npos) ? first : ParseInt(item.substr(dash+1), line, "channel list");
+    if (first < 0 || last > 63 || first > last)
+      throw invalid_argument("histogram spec line " + to_string(line) + ": channels must be in 0-63");
+    for (int c = first; c <= last; c++) mask |= 1ULL << c;
+  }
+  if (mask == 0)
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad channel list " + chans);
+  return mask;
+}
+
+// single comparison such as low>0 or tot>=-1
+static void ParseCut(string cut, histSpec& spec, int line) {
+  size_t pos = cut.find_first_of("<>=!");
+  size_t end = cut.find_first_not_of("<>=!", pos);
+  if (pos == 0 || pos == string::npos || end == string::npos)
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad cut " + cut);
+
+  spec.cutVar = ParseVar(cut.substr(0, pos), line);
+  string op = cut.substr(pos, end-pos);
+  if      (op == "<")  spec.op = CUT_LT;
+  else if (op == "<=") spec.op = CUT_LE;
+  else if (op == ">")  spec.op = CUT_GT;
+  else if (op == ">=") spec.op = CUT_GE;
+  else if (op == "==") spec.op = CUT_EQ;
+  else if (op == "!=") spec.op = CUT_NE;
+  else throw invalid_argument("histogram spec line " + to_string(line) + ": bad cut operator " + op);
+
+  spec.cutVal = ParseDouble(cut.substr(end), line, "cut value");
+}
+
+// checks one axis binning, nbins > 0 and finite lo < hi
+static void ParseAxis(const vector<string>& tok, size_t i, int& nbins, double& lo, double& hi, int line) {
+  nbins = ParseInt(tok[i], line, "number of bins");
+  lo = ParseDouble(tok[i+1], line, "axis limit");
+  hi = ParseDouble(tok[i+2], line, "axis limit");
+  if (nbins <= 0 || !isfinite(lo) || !isfinite(hi) || !(lo < hi))
+    throw invalid_argument("histogram spec line " + to_string(line) + ": bad binning");
+}
+
+// reads and validates the whole spec file, no ROOT objects are created here
+vector<histSpec> histo::LoadSpec(string specFile) {
+  ifstream in(specFile.c_str());
+  if (!in) throw invalid_argument("could not open histogram spec " + specFile);
+
+  vector<histSpec> specs;
+  string buf;
+  int line = 0;
+  while (getline(in, buf)) {
+    line++;
+    buf = buf.substr(0, buf.find('#'));
+    stringstream ss(buf);
+    vector<string> tok;
+    string word;
+    while (ss >> word) tok.push_back(word);
+    if (tok.empty()) continue;
+
+    histSpec spec;
+    spec.name = tok[0];
+    for (const histSpec& other : specs)
+      if (other.name == spec.name)
+        throw invalid_argument("histogram spec line " + to_string(line) + ": duplicate histogram name " + spec.name);
+
+    size_t colon = tok.size() > 1 ? tok[1].find(':') : string::npos;
+    bool is2D = colon != string::npos;
+    size_t nbin = is2D ? 9 : 6;
+    if (tok.size() != nbin && tok.size() != nbin+1)
+      throw invalid_argument("histogram spec line " + to_string(line) + ": wrong number of fields");
+
+    // y:x like TTree::Draw
+    if (is2D) {
+      spec.yvar = ParseVar(tok[1].substr(0, colon), line);
+      spec.xvar = ParseVar(tok[1].substr(colon+1), line);
+    }
+    else spec.xvar = ParseVar(tok[1], line);
+    spec.chanMask = ParseChans(tok[2], line);
+    ParseAxis(tok, 3, spec.nbinsx, spec.xlo, spec.xhi, line);
+    if (is2D) ParseAxis(tok, 6, spec.nbinsy, spec.ylo, spec.yhi, line);
+    if (tok.size() == nbin+1) ParseCut(tok[nbin], spec, line);
+
+    specs.push_back(spec);
+  }
+
+  if (specs.empty())
+    throw invalid_argument("histogram spec " + specFile + " defines no histograms");
+
+  cout << "loaded " << specs.size() << " histograms from " << specFile << endl;
+  return specs;
+}
+
+// warns about histograms that use a variable the acquisition mode does not
+// provide, those would otherwise be written out empty without notice
+void histo::CheckPlanVars(const bool* provided) {
+  if (planChecked) return;
+  planChecked = true;
+
+  static const char* varNames[NSPECVARS] = {"chan", "low", "high", "toa", "tot"};
+  for (const fillStep& step : plan) {
+    const char* name = step.hist2 ? step.hist2->GetName() : step.hist->GetName();
+    unsigned int warned = 0;
+    for (int v : {step.xvar, step.yvar, step.cutVar}) {
+      if (v < 0 || provided[v] || (warned & (1u << v))) continue;
+      warned |= 1u << v;
+      cout << "WARNING: histogram " << name << " uses " << varNames[v]
+           << ", which this acquisition mode does not record" << endl;
+    }
+  }
+}
+
+// runs the fill plan for one hit, vals is indexed by specVar. Channels above
+// 63 cannot be selected by a spec so those hits are skipped.
+void histo::FillPlan(int chan, const float* vals) {
+  if (chan < 0 || chan > 63) return;
+  unsigned long long chanBit = 1ULL << chan;
+  for (const fillStep& step : plan) {
+    if (!(step.chanMask & chanBit)) continue;
+    if (step.op != CUT_NONE) {
+      float v = vals[step.cutVar];
+      bool pass;
+      switch (step.op) {
+        case CUT_LT: pass = v <  step.cutVal; break;
+        case CUT_LE: pass = v <= step.cutVal; break;
+        case CUT_GT: pass = v >  step.cutVal; break;
+        case CUT_GE: pass = v >= step.cutVal; break;
+        case CUT_EQ: pass = v == step.cutVal; break;
+        default:     pass = v != step.cutVal; break;
+      }
+      if (!pass) continue;
+    }
+    if (step.hist2) step.hist2->Fill(vals[step.xvar], vals[step.yvar]);
+    else step.hist->Fill(vals[step.xvar]);
+  }
+}
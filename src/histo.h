@@ -16,31 +16,81 @@
 #include "TH2F.h"
 #include "TCanvas.h"
 #include "TTree.h"
+#include <vector>
 
 using namespace std;
 
+// Histogram spec files: one histogram per line, '#' starts a comment.
+//   name  var    chans  nbins lo hi  [cut]
+//   name  yv:xv  chans  nbinsx xlo xhi nbinsy ylo yhi  [cut]
+// var is one of chan, low, high, toa, tot. chans is "all" or a comma
+// separated list of channels and ranges (e.g. 0,4-7). The optional cut is a
+// single comparison with no spaces, e.g. low>0 or tot>=-1. As in
+// TTree::Draw, 2D variables are given y first (tot:low puts low on the x
+// axis) while the binnings are always listed x first.
+enum specVar { VAR_CHAN, VAR_LOW, VAR_HIGH, VAR_TOA, VAR_TOT, NSPECVARS };
+enum cutOp { CUT_NONE, CUT_LT, CUT_LE, CUT_GT, CUT_GE, CUT_EQ, CUT_NE };
+
+// one parsed line of the spec file, validated before any ROOT object is made
+struct histSpec {
+  string name;
+  int xvar{-1};
+  int yvar{-1}; // -1 for 1D histograms
+  unsigned long long chanMask{0}; // bit n set if channel n is selected
+  int cutVar{-1};
+  cutOp op{CUT_NONE};
+  float cutVal{0};
+  int nbinsx{0};
+  double xlo{0};
+  double xhi{0};
+  int nbinsy{0};
+  double ylo{0};
+  double yhi{0};
+};
+
+// one compiled line of the spec file, filled once per hit
+struct fillStep {
+  TH1F* hist{nullptr};
+  TH2F* hist2{nullptr}; // set instead of hist for 2D histograms
+  int xvar{-1};
+  int yvar{-1};
+  unsigned long long chanMask{0}; // bit n set if channel n is selected
+  int cutVar{-1};
+  cutOp op{CUT_NONE};
+  float cutVal{0};
+};
+
 class histo
 {
 protected:
   TFile* file_read; //!< output root file
 
-  TTree* t;
+  TTree* t{nullptr};
 	double tstamp;
   unsigned short low;
 	unsigned short high;
   float tot;
   float toa;
 
+  vector<fillStep> plan; //!< flat fill plan compiled from the spec file
+  bool planChecked{false}; //!< CheckPlanVars only warns for the first file
+  static vector<histSpec> LoadSpec(string);
+
 public:
   histo();  //!< constructor
+  histo(string);  //!< histogram-only mode, filled from a spec file
   ~histo();
 	void InitSpecMode();
   void FillTree(double, unsigned short, unsigned short, float, float);
 	void FillTree(double, float, float);
+  void FillPlan(int, const float*);
+  void CheckPlanVars(const bool*);
+
+  bool fastMode{false}; //!< no tree, only the spec file histograms
 
-  TH1I* lg_hist;
-  TH1F* tot_hist;
-  TH1F* toa_hist;
-  TH2F* tot_lg_hist;
+  TH1I* lg_hist{nullptr};
+  TH1F* tot_hist{nullptr};
+  TH1F* toa_hist{nullptr};
+  TH2F* tot_lg_hist{nullptr};
 };
 #endif
@@ -20,6 +20,9 @@ int main(int argc, char* argv[])
   string runnum = argv[1];
   stoi(runnum);
 
+  // optional histogram spec file, fills only those histograms and no tree
+  string specfile = (argc > 2) ? argv[2] : "";
+
   // start clock
   clock_t t;
   t = clock();
@@ -35,7 +38,8 @@ int main(int argc, char* argv[])
   files.push_back(namein1);
   string namein;
   
-  histo * Histo = new histo();  // histo class stores all the histograms created
+  // histo class stores all the histograms created
+  histo * Histo = specfile.empty() ? new histo() : new histo(specfile);
   det Det(Histo);               // det class is where we store all of the events and analyse them
   
   for (int i = 0; i < files.size(); i++)